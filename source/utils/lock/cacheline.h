@@ -0,0 +1,11 @@
+#ifndef CACHELINE_H
+#define CACHELINE_H
+
+#include <cstddef>
+
+namespace reinz {
+// 缓存行大小，锁的热点字段按此对齐以避免伪共享
+constexpr std::size_t kCacheLineSize = 64;
+}  // namespace reinz
+
+#endif  // CACHELINE_H
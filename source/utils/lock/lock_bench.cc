@@ -0,0 +1,155 @@
+// 锁竞争基准测试：1~64个线程对同一把锁做加锁/自增/解锁
+// 用法: lock_bench [每个配置的总操作数]
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lock_guard.h"
+#include "mcslock.h"
+#include "rwlock.h"
+#include "spinlock.h"
+#include "ticketlock.h"
+
+namespace {
+
+constexpr int kThreadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+constexpr int kReadRatio = 10;  // 读多写少场景中每10次操作有1次写
+
+// 所有线程就绪后同时开始，返回总耗时(纳秒)
+template <typename Fn>
+int64_t runThreads(int threads, Fn&& fn) {
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (int i = 0; i < threads; ++i) {
+    workers.emplace_back([&, i] {
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      fn(i);
+    });
+  }
+  while (ready.load() != threads) {
+    std::this_thread::yield();
+  }
+  auto begin = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& t : workers) {
+    t.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+      .count();
+}
+
+void report(const char* name, const char* mode, int threads, uint64_t ops,
+            int64_t ns, bool ok) {
+  fmt::print("{:<12} {:<10} {:>3} threads  {:>9.1f} ns/op  {:>8.2f} Mops/s{}\n",
+             name, mode, threads, static_cast<double>(ns) / ops,
+             ops * 1e3 / ns, ok ? "" : "  [COUNT MISMATCH]");
+}
+
+// 互斥场景：所有操作都是写
+template <typename Mutex>
+void benchExclusive(const char* name, uint64_t total_ops) {
+  for (int threads : kThreadCounts) {
+    Mutex lock;
+    uint64_t counter = 0;
+    const uint64_t per_thread = total_ops / threads;
+    int64_t ns = runThreads(threads, [&](int) {
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        reinz::LockGuard<Mutex> guard(lock);
+        ++counter;
+      }
+    });
+    const uint64_t ops = per_thread * threads;
+    report(name, "exclusive", threads, ops, ns, counter == ops);
+  }
+}
+
+// 读多写少场景：读者使用 lock_shared
+template <typename Mutex>
+void benchReadMostly(const char* name, uint64_t total_ops) {
+  for (int threads : kThreadCounts) {
+    Mutex lock;
+    uint64_t counter = 0;
+    std::atomic<uint64_t> sink{0};
+    const uint64_t per_thread = total_ops / threads;
+    int64_t ns = runThreads(threads, [&](int) {
+      uint64_t local = 0;
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        if (i % kReadRatio == 0) {
+          reinz::LockGuard<Mutex> guard(lock);
+          ++counter;
+        } else {
+          reinz::ReadLockGuard<Mutex> guard(lock);
+          local += counter;
+        }
+      }
+      sink.fetch_add(local, std::memory_order_relaxed);
+    });
+    const uint64_t ops = per_thread * threads;
+    const uint64_t writes = (per_thread + kReadRatio - 1) / kReadRatio;
+    report(name, "read90", threads, ops, ns, counter == writes * threads);
+  }
+}
+
+// 顺序锁的读多写少场景
+void benchSeqLock(uint64_t total_ops) {
+  for (int threads : kThreadCounts) {
+    reinz::SeqLock lock;
+    std::atomic<uint64_t> counter{0};  // 原子变量避免读者的数据竞争
+    std::atomic<uint64_t> sink{0};
+    const uint64_t per_thread = total_ops / threads;
+    int64_t ns = runThreads(threads, [&](int) {
+      uint64_t local = 0;
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        if (i % kReadRatio == 0) {
+          reinz::LockGuard<reinz::SeqLock> guard(lock);
+          counter.store(counter.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        } else {
+          uint64_t value;
+          uint32_t seq;
+          do {
+            seq = lock.read_begin();
+            value = counter.load(std::memory_order_relaxed);
+          } while (lock.read_retry(seq));
+          local += value;
+        }
+      }
+      sink.fetch_add(local, std::memory_order_relaxed);
+    });
+    const uint64_t ops = per_thread * threads;
+    const uint64_t writes = (per_thread + kReadRatio - 1) / kReadRatio;
+    report("SeqLock", "read90", threads, ops, ns,
+           counter.load() == writes * threads);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t total_ops = 1 << 20;
+  if (argc > 1) {
+    total_ops = std::strtoull(argv[1], nullptr, 10);
+  }
+
+  benchExclusive<std::mutex>("std::mutex", total_ops);
+  benchExclusive<reinz::SpinLock>("SpinLock", total_ops);
+  benchExclusive<reinz::TicketLock>("TicketLock", total_ops);
+  benchExclusive<reinz::McsLock>("McsLock", total_ops);
+  benchExclusive<reinz::RWSpinLock>("RWSpinLock", total_ops);
+  benchReadMostly<reinz::RWSpinLock>("RWSpinLock", total_ops);
+  benchSeqLock(total_ops);
+  return 0;
+}
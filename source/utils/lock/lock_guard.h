@@ -0,0 +1,40 @@
+#ifndef LOCK_GUARD_H
+#define LOCK_GUARD_H
+
+namespace reinz {
+/**
+ * @brief 通用的作用域锁，适用于任何提供 lock()/unlock() 的锁
+ */
+template <typename Mutex>
+class LockGuard {
+ public:
+  explicit LockGuard(Mutex &lock) : lock_(lock) { lock_.lock(); }
+
+  ~LockGuard() noexcept { lock_.unlock(); }
+
+  LockGuard(const LockGuard &) = delete;
+  LockGuard &operator=(const LockGuard &) = delete;
+
+ private:
+  Mutex &lock_;
+};
+
+/**
+ * @brief 作用域读锁，适用于提供 lock_shared()/unlock_shared() 的锁
+ */
+template <typename Mutex>
+class ReadLockGuard {
+ public:
+  explicit ReadLockGuard(Mutex &lock) : lock_(lock) { lock_.lock_shared(); }
+
+  ~ReadLockGuard() noexcept { lock_.unlock_shared(); }
+
+  ReadLockGuard(const ReadLockGuard &) = delete;
+  ReadLockGuard &operator=(const ReadLockGuard &) = delete;
+
+ private:
+  Mutex &lock_;
+};
+}  // namespace reinz
+
+#endif  // LOCK_GUARD_H
@@ -0,0 +1,117 @@
+#ifndef MCSLOCK_H
+#define MCSLOCK_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cacheline.h"
+
+namespace reinz {
+/**
+ * @brief MCS队列锁
+ * @details 每个等待者只在自己的节点上自旋，锁的交接只触碰一条缓存行，
+ *  适合竞争激烈的场景。节点取自线程本地的空闲链表，因此同一线程
+ *  可以同时持有多把MCS锁，解锁顺序不限；首次加锁时会分配节点
+ */
+class McsLock {
+ public:
+  McsLock() = default;
+  ~McsLock() = default;
+
+  // 禁止拷贝与赋值
+  McsLock(const McsLock &) = delete;
+  McsLock &operator=(const McsLock &) = delete;
+
+  void lock() {
+    Node *node = acquireNode();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+
+    // acq_rel: 发布节点初始化，同时获取前驱的写入
+    Node *prev = tail_.exchange(node, std::memory_order_acq_rel);
+    if (prev != nullptr) {
+      prev->next.store(node, std::memory_order_release);
+      while (node->locked.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+    }
+    owner_ = node;
+  }
+
+  void unlock() noexcept {
+    Node *node = owner_;
+    Node *next = node->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      Node *expected = node;
+      if (tail_.compare_exchange_strong(expected, nullptr,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+        releaseNode(node);
+        return;
+      }
+      // 后继已入队但还未链接到本节点
+      while ((next = node->next.load(std::memory_order_acquire)) == nullptr) {
+        std::this_thread::yield();
+      }
+    }
+    next->locked.store(false, std::memory_order_release);
+    releaseNode(node);
+  }
+
+  bool try_lock() {
+    Node *node = acquireNode();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+
+    Node *expected = nullptr;
+    if (tail_.compare_exchange_strong(expected, node,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed)) {
+      owner_ = node;
+      return true;
+    }
+    releaseNode(node);
+    return false;
+  }
+
+ private:
+  struct alignas(kCacheLineSize) Node {
+    std::atomic<Node *> next{nullptr};
+    std::atomic<bool> locked{false};
+  };
+
+  // 线程本地的节点池，节点随线程退出释放
+  struct NodePool {
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<Node *> free_list;
+  };
+
+  static NodePool &pool() noexcept {
+    thread_local NodePool pool;
+    return pool;
+  }
+
+  static Node *acquireNode() {
+    NodePool &p = pool();
+    if (p.free_list.empty()) {
+      p.nodes.push_back(std::make_unique<Node>());
+      return p.nodes.back().get();
+    }
+    Node *node = p.free_list.back();
+    p.free_list.pop_back();
+    return node;
+  }
+
+  static void releaseNode(Node *node) { pool().free_list.push_back(node); }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<Node *> tail_{nullptr};  // 队尾节点
+  // 持有者节点，只由持有者读写；与 tail_ 分开，避免新等待者入队时
+  // 使持有者的缓存行失效
+  alignas(kCacheLineSize) Node *owner_ = nullptr;
+};
+}  // namespace reinz
+
+#endif  // MCSLOCK_H
@@ -0,0 +1,162 @@
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "cacheline.h"
+#include "spinlock.h"
+
+namespace reinz {
+/**
+ * @brief 读写自旋锁
+ * @details 读者之间不互斥，适合读多写少的数据。写者到达后置等待位，
+ *  阻止新读者进入，避免写者饥饿
+ */
+class RWSpinLock {
+ public:
+  RWSpinLock() = default;
+  ~RWSpinLock() = default;
+
+  // 禁止拷贝与赋值
+  RWSpinLock(const RWSpinLock &) = delete;
+  RWSpinLock &operator=(const RWSpinLock &) = delete;
+
+  // 写锁
+  void lock() noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while (true) {
+      if ((state & ~kPending) == 0) {
+        // 获得写锁的同时清除等待位
+        if (state_.compare_exchange_weak(state, kWriter,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+      if ((state & kPending) == 0) {
+        state_.fetch_or(kPending, std::memory_order_relaxed);
+      }
+      std::this_thread::yield();
+      state = state_.load(std::memory_order_relaxed);
+    }
+  }
+
+  void unlock() noexcept {
+    // 保留其他写者设置的等待位
+    state_.fetch_and(~kWriter, std::memory_order_release);
+  }
+
+  bool try_lock() noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    return (state & ~kPending) == 0 &&
+           state_.compare_exchange_strong(state, kWriter,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  // 读锁
+  void lock_shared() noexcept {
+    while (!try_lock_shared()) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock_shared() noexcept {
+    state_.fetch_sub(kReader, std::memory_order_release);
+  }
+
+  bool try_lock_shared() noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    return (state & (kWriter | kPending)) == 0 &&
+           state_.compare_exchange_strong(state, state + kReader,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kWriter = 1;   // 写者持有
+  static constexpr uint32_t kPending = 2;  // 写者等待
+  static constexpr uint32_t kReader = 4;   // 每个读者的计数单位
+
+  alignas(kCacheLineSize) std::atomic<uint32_t> state_{0};
+};
+
+/**
+ * @brief 顺序锁
+ * @details 读者不写共享内存，写者优先。读者读取期间若发生写入则重试，
+ *  只适用于可按值拷贝的小块数据
+ *
+ *  读者用法:
+ *  @code
+ *  uint32_t seq;
+ *  do {
+ *    seq = lock.read_begin();
+ *    copy = data;
+ *  } while (lock.read_retry(seq));
+ *  @endcode
+ */
+class SeqLock {
+ public:
+  SeqLock() = default;
+  ~SeqLock() = default;
+
+  // 禁止拷贝与赋值
+  SeqLock(const SeqLock &) = delete;
+  SeqLock &operator=(const SeqLock &) = delete;
+
+  // 写锁，写者之间互斥
+  void lock() noexcept {
+    writer_.lock();
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+    // 序号变为奇数后才允许写数据
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void unlock() noexcept {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+    writer_.unlock();
+  }
+
+  bool try_lock() noexcept {
+    if (!writer_.try_lock()) return false;
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 开始读取，等待正在进行的写入结束
+   * @return 本次读取的序号
+   */
+  uint32_t read_begin() const noexcept {
+    uint32_t seq = seq_.load(std::memory_order_acquire);
+    while (seq & 1) {
+      std::this_thread::yield();
+      seq = seq_.load(std::memory_order_acquire);
+    }
+    return seq;
+  }
+
+  /**
+   * @brief 读取期间是否发生过写入
+   * @return true 表示需要重新读取
+   */
+  bool read_retry(uint32_t seq) const noexcept {
+    // 数据读取不得重排到序号检查之后
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return seq_.load(std::memory_order_relaxed) != seq;
+  }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<uint32_t> seq_{0};  // 奇数表示写入中
+  SpinLock writer_;
+};
+}  // namespace reinz
+
+#endif  // RWLOCK_H
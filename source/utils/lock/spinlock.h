@@ -4,6 +4,8 @@
 #include <atomic>
 #include <thread>
 
+#include "cacheline.h"
+
 namespace reinz {
 class SpinLock {
  public:
@@ -16,7 +18,8 @@ class SpinLock {
 
   void lock() noexcept {
     // memory_order_acquire:后面访存指令勿重排至此条指令之前
-    while (!flag_.test_and_set(std::memory_order_acquire)) {
+    // test_and_set 返回旧值，旧值为 true 说明锁被占用
+    while (flag_.test_and_set(std::memory_order_acquire)) {
       std::this_thread::yield();
     }
   }
@@ -31,7 +34,7 @@ class SpinLock {
   }
 
  private:
-  std::atomic_flag flag_;
+  alignas(kCacheLineSize) std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
 };
 
 class SpinlockGuard {
@@ -0,0 +1,52 @@
+#ifndef TICKETLOCK_H
+#define TICKETLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "cacheline.h"
+
+namespace reinz {
+/**
+ * @brief 排队自旋锁
+ * @details 按取号顺序获得锁(FIFO)，避免SpinLock在竞争下的饥饿问题
+ */
+class TicketLock {
+ public:
+  TicketLock() = default;
+  ~TicketLock() = default;
+
+  // 禁止拷贝与赋值
+  TicketLock(const TicketLock &) = delete;
+  TicketLock &operator=(const TicketLock &) = delete;
+
+  void lock() noexcept {
+    // 取号只需保证原子性，同步由 serving_ 的 acquire 完成
+    const uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    while (serving_.load(std::memory_order_acquire) != ticket) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock() noexcept {
+    // 只有持有者会修改 serving_，无需 RMW
+    const uint32_t cur = serving_.load(std::memory_order_relaxed);
+    serving_.store(cur + 1, std::memory_order_release);
+  }
+
+  bool try_lock() noexcept {
+    uint32_t cur = serving_.load(std::memory_order_acquire);
+    uint32_t expected = cur;
+    return next_.compare_exchange_strong(expected, cur + 1,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed);
+  }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<uint32_t> next_{0};     // 下一个号码
+  alignas(kCacheLineSize) std::atomic<uint32_t> serving_{0};  // 当前服务号码
+};
+}  // namespace reinz
+
+#endif  // TICKETLOCK_H
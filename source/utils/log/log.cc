@@ -1,8 +1,12 @@
 #include "log.hpp"
 // #include "../util.h"
 
+#include <poll.h>
+
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <cstddef>
 #include <functional>
 #include <iterator>
@@ -49,16 +53,395 @@ static const char *toString(LogLevel::Level level) {
 }
 
 std::shared_ptr<LogFormatter> LogAppender::getFormatter() {
-  MutexGuard guard(lock_);
+  ReadGuard guard(lock_);
   return formatter_;
 }
 
 void LogAppender::setFormatter(std::shared_ptr<LogFormatter> formatter) {
-  MutexGuard guard(lock_);
+  WriteGuard guard(lock_);
   formatter_ = formatter;
   has_formatter_ = formatter_ != nullptr ? true : false;
 }
 
+void LogAppender::setRepeatWindow(uint32_t window_ms) {
+  std::shared_ptr<LogEvent> summary;
+  {
+    WriteGuard guard(lock_);
+    if (repeat_filter_) summary = repeat_filter_->flush();
+    repeat_filter_ = window_ms > 0
+                         ? std::make_shared<LogRepeatFilter>(window_ms)
+                         : nullptr;
+  }
+  if (summary) logSummary(summary->getLogger(), summary);
+}
+
+void LogAppender::flushRepeat() {
+  std::shared_ptr<LogRepeatFilter> filter;
+  {
+    ReadGuard guard(lock_);
+    filter = repeat_filter_;
+  }
+  if (!filter) return;
+  auto summary = filter->flush();
+  if (summary) logSummary(summary->getLogger(), summary);
+}
+
+void LogAppender::flush() { flushRepeat(); }
+
+void LogAppender::flushExpiredRepeat() {
+  std::shared_ptr<LogRepeatFilter> filter;
+  {
+    ReadGuard guard(lock_);
+    filter = repeat_filter_;
+  }
+  // 定时器线程不能持有日志器：若它成为最后一个引用，日志器会在这里
+  // 析构并销毁Appender，而Appender的析构函数要等待本线程退出
+  if (filter) logSummary(nullptr, filter->flushExpired());
+}
+
+void LogAppender::logSummary(std::shared_ptr<Logger> logger,
+                             const std::shared_ptr<LogEvent> &summary) {
+  if (!summary) return;
+  // logger 为空时摘要照常输出
+  log(std::move(logger), summary->getLevel(), summary);
+}
+
+void LogAppender::append(std::shared_ptr<Logger> logger, LogLevel::Level level,
+                         std::shared_ptr<LogEvent> event) {
+  std::shared_ptr<LogRepeatFilter> filter;
+  {
+    ReadGuard guard(lock_);
+    filter = repeat_filter_;
+  }
+  if (!filter) {
+    log(std::move(logger), level, std::move(event));
+    return;
+  }
+
+  std::shared_ptr<LogEvent> summary;
+  bool pass = filter->filter(level, event, summary);
+  if (summary) log(logger, summary->getLevel(), summary);
+  if (pass) log(std::move(logger), level, std::move(event));
+}
+
+LogRepeatFilter::LogRepeatFilter(uint32_t window_ms) : window_ms_(window_ms) {}
+
+bool LogRepeatFilter::filter(LogLevel::Level level,
+                             const std::shared_ptr<LogEvent> &event,
+                             std::shared_ptr<LogEvent> &summary) {
+  size_t hash = std::hash<std::string>{}(event->getContent());
+  // 事件时间只精确到秒，窗口使用单调时钟计时
+  auto now = std::chrono::steady_clock::now();
+
+  MutexGuard guard(lock_);
+  // 调用位置来自 __FILE__ 字面量，直接比较指针即可
+  bool same = hash == hash_ && line_ == event->getLine() &&
+              file_ == event->getFile() && level_ == level;
+  if (same && now - first_ < std::chrono::milliseconds(window_ms_)) {
+    ++repeats_;
+    last_ = event;
+    return false;
+  }
+
+  // 重复段结束或窗口超时，补发摘要并以当前日志开始新的一段
+  summary = makeSummary();
+  file_ = event->getFile();
+  line_ = event->getLine();
+  level_ = level;
+  hash_ = hash;
+  first_ = now;
+  return true;
+}
+
+std::shared_ptr<LogEvent> LogRepeatFilter::flush() {
+  MutexGuard guard(lock_);
+  auto summary = makeSummary();
+  reset();
+  return summary;
+}
+
+std::shared_ptr<LogEvent> LogRepeatFilter::flushExpired() {
+  MutexGuard guard(lock_);
+  if (repeats_ == 0 || std::chrono::steady_clock::now() - first_ <
+                           std::chrono::milliseconds(window_ms_)) {
+    return nullptr;
+  }
+  auto summary = makeSummary();
+  reset();
+  return summary;
+}
+
+void LogRepeatFilter::reset() {
+  // 清空状态，之后相同的日志重新输出
+  file_ = nullptr;
+  line_ = 0;
+  level_ = LogLevel::UNKNOWN;
+  hash_ = 0;
+}
+
+std::shared_ptr<LogEvent> LogRepeatFilter::makeSummary() {
+  if (repeats_ == 0) return nullptr;
+
+  auto summary = std::make_shared<LogEvent>(
+      last_->getWeakLogger(), level_, last_->getFile(),
+      last_->getLine(), last_->getElapse(), last_->getThreadId(),
+      std::chrono::system_clock::to_time_t(last_->getTime()),
+      last_->getThreadName());
+  summary->format("last message repeated {} times", repeats_);
+
+  repeats_ = 0;
+  last_.reset();
+  return summary;
+}
+
+FileLogAppender::FileLogAppender(const std::string &filename,
+                                 uint32_t index_every)
+    : filename_(filename),
+      index_every_(index_every),
+      timer_(kFlushIntervalMs, [this] {
+        flushExpiredRepeat();
+        flushFile();
+      }) {
+  reopen();
+}
+
+FileLogAppender::~FileLogAppender() {
+  timer_.stop();
+  flush();
+  MutexGuard guard(file_lock_);
+  if (index_) index_->close();
+}
+
+void FileLogAppender::log(std::shared_ptr<Logger> logger, LogLevel::Level level,
+                          std::shared_ptr<LogEvent> event) {
+  if (level < level_) return;
+  auto formatter = getFormatter();
+  if (!formatter) return;
+
+  std::string str = formatter->format(logger, level, event);
+  auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     event->getTime().time_since_epoch())
+                     .count();
+
+  MutexGuard guard(file_lock_);
+  if (!filestream_) return;
+  filestream_.write(str.data(), str.size());
+  if (index_) index_->append(time_ms, offset_, str.size(), level);
+  offset_ += str.size();
+}
+
+void FileLogAppender::flush() {
+  flushRepeat();
+  flushFile();
+}
+
+void FileLogAppender::flushFile() {
+  MutexGuard guard(file_lock_);
+  // 先刷日志再刷索引，索引项不会指向尚未落盘的数据
+  filestream_.flush();
+  if (index_) index_->flush();
+}
+
+bool FileLogAppender::reopen() {
+  MutexGuard guard(file_lock_);
+  if (filestream_.is_open()) filestream_.close();
+  filestream_.open(filename_, std::ios::app | std::ios::binary);
+  if (!filestream_) return false;
+
+  // 追加模式下从文件末尾开始计算偏移
+  filestream_.seekp(0, std::ios::end);
+  offset_ = static_cast<uint64_t>(filestream_.tellp());
+
+  if (index_every_ > 0) {
+    if (!index_) index_ = std::make_unique<LogIndexWriter>(index_every_);
+    index_->open(filename_ + ".idx");
+  }
+  return true;
+}
+
+LogFlushTimer::LogFlushTimer(uint32_t interval_ms,
+                             std::function<void()> callback)
+    : interval_ms_(interval_ms), callback_(std::move(callback)) {
+  thread_ = std::thread([this] {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cond_.wait_for(lock, std::chrono::milliseconds(interval_ms_),
+                     [this] { return stopped_ || wakeup_; });
+      if (stopped_) break;
+      wakeup_ = false;
+      lock.unlock();
+      callback_();
+      lock.lock();
+    }
+  });
+}
+
+LogFlushTimer::~LogFlushTimer() { stop(); }
+
+void LogFlushTimer::wakeup() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (wakeup_ || stopped_) return;  // 已有未处理的唤醒，不必重复通知
+    wakeup_ = true;
+  }
+  cond_.notify_one();
+}
+
+void LogFlushTimer::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cond_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+// 按级别着色的ANSI转义序列
+static const char *levelColor(LogLevel::Level level) {
+  switch (level) {
+    case LogLevel::DEBUG:
+      return "\033[36m";
+    case LogLevel::INFO:
+      return "\033[32m";
+    case LogLevel::WARN:
+      return "\033[33m";
+    case LogLevel::ERROR:
+      return "\033[31m";
+    case LogLevel::FATAL:
+      return "\033[1;31m";
+    default:
+      return "";
+  }
+}
+
+ConsoleLogAppender::ConsoleLogAppender(int fd, size_t batch_size,
+                                       size_t max_pending)
+    : fd_(fd),
+      color_(::isatty(fd) == 1),
+      batch_size_(batch_size),
+      max_pending_(std::max(max_pending, batch_size)),
+      timer_(kFlushIntervalMs, [this] {
+        flushExpiredRepeat();
+        drain();
+      }) {
+  front_.reserve(batch_size_);
+  back_.reserve(batch_size_);
+}
+
+ConsoleLogAppender::~ConsoleLogAppender() {
+  timer_.stop();
+  flush(1000);
+}
+
+void ConsoleLogAppender::log(std::shared_ptr<Logger> logger,
+                             LogLevel::Level level,
+                             std::shared_ptr<LogEvent> event) {
+  if (level < level_) return;
+
+  fmt::memory_buffer buffer;
+  if (color_) {
+    const char *color = levelColor(level);
+    buffer.append(color, color + std::strlen(color));
+  }
+  {
+    // 持读锁格式化，每条日志不再复制一次 formatter_ 的 shared_ptr
+    ReadGuard guard(lock_);
+    if (!formatter_) return;
+    formatter_->format(buffer, logger, level, event);
+  }
+  if (color_) {
+    // 颜色不跨越换行
+    bool newline = buffer.size() > 0 && buffer[buffer.size() - 1] == '\n';
+    if (newline) buffer.resize(buffer.size() - 1);
+    static constexpr char kReset[] = "\033[0m\n";
+    buffer.append(kReset, kReset + sizeof(kReset) - (newline ? 1 : 2));
+  }
+
+  bool full;
+  {
+    MutexGuard guard(buffer_lock_);
+    // 积压包括正在写出、可能因EAGAIN滞留的 back_
+    size_t pending =
+        front_.size() + back_pending_.load(std::memory_order_relaxed);
+    if (pending + buffer.size() > max_pending_) {
+      ++dropped_;
+      return;
+    }
+    front_.append(buffer.data(), buffer.size());
+    full = front_.size() >= batch_size_;
+  }
+
+  // 生产者不写fd，写出都交给定时器线程：终端逐条、其他情况攒满一批
+  // 或遇到错误日志时提前唤醒它，剩余的按间隔写出
+  if (full || color_ || level >= LogLevel::ERROR) timer_.wakeup();
+}
+
+void ConsoleLogAppender::flush() { flush(0); }
+
+void ConsoleLogAppender::flush(int timeout_ms) {
+  flushRepeat();
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (!drain()) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now())
+                    .count();
+    if (left <= 0) return;
+    // 等待fd可写或其他线程完成写出
+    struct pollfd pfd = {fd_, POLLOUT, 0};
+    ::poll(&pfd, 1, static_cast<int>(std::min<int64_t>(left, 10)));
+  }
+}
+
+bool ConsoleLogAppender::drain() {
+  while (true) {
+    if (flushing_.exchange(true, std::memory_order_acquire)) return false;
+    bool done = writeOut();
+    flushing_.store(false, std::memory_order_release);
+    if (!done) return false;
+
+    // 写出期间追加、但因 flushing_ 未能写出的日志，由本线程继续写出
+    MutexGuard guard(buffer_lock_);
+    if (front_.empty() && dropped_ == 0) return true;
+  }
+}
+
+bool ConsoleLogAppender::writeOut() {
+  while (true) {
+    if (back_written_ == back_.size()) {
+      back_.clear();
+      back_written_ = 0;
+      MutexGuard guard(buffer_lock_);
+      if (front_.empty() && dropped_ == 0) return true;
+      front_.swap(back_);
+      if (dropped_ > 0) {
+        fmt::format_to(std::back_inserter(back_),
+                       "[log] dropped {} records on fd {}\n", dropped_, fd_);
+        dropped_ = 0;
+      }
+      back_pending_.store(back_.size(), std::memory_order_relaxed);
+    }
+
+    ssize_t n = ::write(fd_, back_.data() + back_written_,
+                        back_.size() - back_written_);
+    if (n >= 0) {
+      back_written_ += static_cast<size_t>(n);
+      back_pending_.store(back_.size() - back_written_,
+                          std::memory_order_relaxed);
+    } else if (errno == EINTR) {
+      continue;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      // 管道已满，保留未写完的数据，下次再写
+      return false;
+    } else {
+      // 其他错误无法恢复，丢弃这一批
+      back_written_ = back_.size();
+      back_pending_.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
 Logger::Logger(const std::string &name) : name_(name), level_(LogLevel::DEBUG) {
   // formatter_.reset(new LogFormatter(
   //     "%d{%Y-%m-%d %H:%M:%S}%T%t%T%N%T%T[%p]%T[%c]%T%f:%l%T%m%n"));
@@ -67,31 +450,102 @@ Logger::Logger(const std::string &name) : name_(name), level_(LogLevel::DEBUG) {
 }
 
 void Logger::log(LogLevel::Level level, std::shared_ptr<LogEvent> event) {
-  if (level < level_) return;
-  {
-    MutexGuard lock(lock_);
-
-    if (!appenders_.empty()) {
-      auto self = shared_from_this();  // 仅在需要的时候才获取共享指针
-      for (auto &appender : appenders_) {
-        appender->log(self, level, event);
-      }
-      return;
-    }
+  if (level < level_) {
+    backtrace_.push(level, std::move(event));
+    return;
   }
+  if (backtrace_.isTrigger(level)) dumpBacktrace();
+
   // 没有appenders且有root_logger_ 则转发到root_logger
-  if (root_logger_) {
+  if (!callAppenders(level, event) && root_logger_) {
     root_logger_->log(level, event);
   }
 }
 
+bool Logger::callAppenders(LogLevel::Level level,
+                           const std::shared_ptr<LogEvent> &event) {
+  MutexGuard lock(lock_);
+  if (appenders_.empty()) return false;
+
+  auto self = shared_from_this();  // 仅在需要的时候才获取共享指针
+  for (auto &appender : appenders_) {
+    appender->append(self, level, event);
+  }
+  return true;
+}
+
+void Logger::enableBacktrace(size_t size, LogLevel::Level trigger) {
+  backtrace_.enable(size, trigger);
+}
+
+void Logger::disableBacktrace() { backtrace_.disable(); }
+
+void Logger::dumpBacktrace() {
+  for (auto &item : backtrace_.drain()) {
+    // 保存的事件低于root_logger的级别也要输出，直接交给其Appender
+    if (!callAppenders(item.level, item.event) && root_logger_) {
+      root_logger_->callAppenders(item.level, item.event);
+    }
+  }
+}
+
+void LogBacktrace::enable(size_t capacity, LogLevel::Level trigger) {
+  MutexGuard guard(lock_);
+  items_.assign(capacity, Item{});
+  head_ = 0;
+  size_ = 0;
+  trigger_.store(trigger, std::memory_order_relaxed);
+  enabled_.store(capacity > 0, std::memory_order_relaxed);
+}
+
+void LogBacktrace::disable() {
+  std::vector<Item> items;
+  {
+    MutexGuard guard(lock_);
+    enabled_.store(false, std::memory_order_relaxed);
+    items.swap(items_);
+    head_ = 0;
+    size_ = 0;
+  }
+}
+
+void LogBacktrace::push(LogLevel::Level level,
+                        std::shared_ptr<LogEvent> event) {
+  if (!isEnabled()) return;
+
+  Item old;  // 被覆盖的事件在锁外释放
+  {
+    MutexGuard guard(lock_);
+    if (items_.empty()) return;
+    old = std::move(items_[head_]);
+    items_[head_] = Item{level, std::move(event)};
+    head_ = (head_ + 1) % items_.size();
+    if (size_ < items_.size()) ++size_;
+  }
+}
+
+std::vector<LogBacktrace::Item> LogBacktrace::drain() {
+  std::vector<Item> result;
+  MutexGuard guard(lock_);
+  if (size_ == 0) return result;
+
+  result.reserve(size_);
+  size_t begin = (head_ + items_.size() - size_) % items_.size();
+  for (size_t i = 0; i < size_; ++i) {
+    result.push_back(std::move(items_[(begin + i) % items_.size()]));
+  }
+  head_ = 0;
+  size_ = 0;
+  return result;
+}
+
 void Logger::setFormatter(std::shared_ptr<LogFormatter> formatter) {
   {
     MutexGuard lock(lock_);
     formatter_ = formatter;
   }
   for (auto &i : appenders_) {
-    MutexGuard appender_lock(i->lock_);
+    WriteGuard appender_lock(i->lock_);
     if (!i->has_formatter_) {
       i->formatter_ = formatter_;
     }
@@ -203,11 +657,23 @@ void LogFormatter::init() {
   }
 
   // 构建最终格式项列表
+  simple_ = true;
   for (const auto &item : parsed_patterns) {
     const auto &str = std::get<0>(item);
     const auto &fmt = std::get<1>(item);
     const int type = std::get<2>(item);
 
+    if (type == 0 || str == "n") {
+      // 相邻的字面量合并为一个片段
+      const std::string literal = type == 0 ? str : "\n";
+      if (pieces_.empty() || pieces_.back().empty()) pieces_.emplace_back();
+      pieces_.back() += literal;
+    } else if (str == "m") {
+      pieces_.emplace_back();
+    } else {
+      simple_ = false;
+    }
+
     if (type == 0) {
       items_.push_back(std::make_shared<StringFormatItem>(str));
     } else {
@@ -227,11 +693,24 @@ std::string LogFormatter::format(std::shared_ptr<Logger> logger,
                                  LogLevel::Level level,
                                  std::shared_ptr<LogEvent> event) {
   fmt::memory_buffer buffer;
+  format(buffer, logger, level, event);
+  return fmt::to_string(buffer);
+}
 
+void LogFormatter::format(fmt::memory_buffer &buffer,
+                          const std::shared_ptr<Logger> &logger,
+                          LogLevel::Level level,
+                          const std::shared_ptr<LogEvent> &event) {
+  if (simple_) {
+    for (const auto &piece : pieces_) {
+      const std::string &str = piece.empty() ? event->getContent() : piece;
+      buffer.append(str.data(), str.data() + str.size());
+    }
+    return;
+  }
   for (const auto &item : items_) {
     item->format(buffer, logger, level, event);
   }
-  return fmt::to_string(buffer);
 }
 
 }  // namespace Logging
\ No newline at end of file
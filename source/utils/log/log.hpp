@@ -5,14 +5,18 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <sys/types.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
-// #include <mutex>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -21,11 +25,16 @@
 
 #include "../util.h"
 #include "fmt/base.h"
+#include "log_index.hpp"
 
 namespace Logging {
 
 using MutexType = reinz::SpinLock;
 using MutexGuard = reinz::SpinlockGuard;
+// 读多写少的数据使用读写锁
+using RWMutexType = reinz::RWSpinLock;
+using ReadGuard = reinz::ReadLockGuard<RWMutexType>;
+using WriteGuard = reinz::LockGuard<RWMutexType>;
 
 class Logger;
 class LogAppender;
@@ -33,6 +42,7 @@ class LogFormatter;
 class LoggerManager;
 class LogQueue;
 class LogEvent;
+class LogRepeatFilter;
 
 class LogLevel {
  public:
@@ -59,7 +69,7 @@ class LogLevel {
 
 class LogEvent {
  public:
-  LogEvent(std::shared_ptr<Logger> logger, LogLevel::Level level,
+  LogEvent(std::weak_ptr<Logger> logger, LogLevel::Level level,
            const char* file, uint32_t line, uint32_t elapse,
            std::thread::id thread_id, /*uint32_t fiber_id,*/ std::time_t time,
            const std::string& thread_name);
@@ -80,9 +90,17 @@ class LogEvent {
 
   // std::stringstream& getSS() { return ss_; }
 
-  std::string getContent() const { return content_; }
+  const std::string& getContent() const { return content_; }
 
-  std::shared_ptr<Logger> getLogger() const { return logger_; }
+  /**
+   * @brief 获得日志器，日志器已销毁时返回空
+   */
+  std::shared_ptr<Logger> getLogger() const { return logger_.lock(); }
+
+  /**
+   * @brief 获得日志器的弱引用，不会延长日志器的生命周期
+   */
+  const std::weak_ptr<Logger>& getWeakLogger() const { return logger_; }
 
   const std::string& getThreadName() const { return thread_name_; }
 
@@ -90,7 +108,9 @@ class LogEvent {
 
   template <typename... Args>
   void format(const char* fmt, Args&&... args) {
-    content_ += fmt::format(fmt, std::forward<Args>(args)...);
+    // 直接格式化到 content_，不生成临时string
+    fmt::format_to(std::back_inserter(content_), fmt,
+                   std::forward<Args>(args)...);
   }
 
  private:
@@ -103,10 +123,63 @@ class LogEvent {
   std::string thread_name_;
   // std::stringstream ss_; // 采用fmt库后，使用string更加高效
   std::string content_;  // 日志内容
-  std::shared_ptr<Logger> logger_;
+  // 不持有日志器：事件会被保存在日志器自身的回溯缓冲区及其Appender的
+  // 重复折叠中，持有会形成循环引用。日志器销毁后输出的事件(例如Appender
+  // 析构时补发的折叠摘要)交给Appender的 logger 参数为空
+  std::weak_ptr<Logger> logger_;
   LogLevel::Level level_;
 };
 
+// 重复日志折叠
+class LogRepeatFilter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param window_ms 折叠窗口(毫秒)
+   * @details 调用位置、级别与消息哈希都相同的连续日志视为重复，
+   *  窗口内只输出第一条，随后补一条 "repeated N times" 摘要
+   */
+  explicit LogRepeatFilter(uint32_t window_ms = 1000);
+
+  /**
+   * @brief 判断日志事件是否需要输出
+   * @param level 日志级别
+   * @param event 日志事件
+   * @param summary 若上一段重复结束，返回对应的摘要事件，否则为空
+   * @return false 表示该事件被折叠
+   */
+  bool filter(LogLevel::Level level, const std::shared_ptr<LogEvent>& event,
+              std::shared_ptr<LogEvent>& summary);
+
+  /**
+   * @brief 取出尚未输出的摘要事件，没有则返回空
+   */
+  std::shared_ptr<LogEvent> flush();
+
+  /**
+   * @brief 折叠窗口已过时取出摘要事件，否则返回空
+   * @details 重复的日志停止后不会再有新日志触发摘要，需定时调用
+   */
+  std::shared_ptr<LogEvent> flushExpired();
+
+  uint32_t getWindow() const { return window_ms_; }
+
+ private:
+  std::shared_ptr<LogEvent> makeSummary();
+  void reset();
+
+ private:
+  uint32_t window_ms_;
+  const char* file_ = nullptr;                   // 上一条日志的文件名
+  int32_t line_ = 0;                             // 上一条日志的行号
+  LogLevel::Level level_ = LogLevel::UNKNOWN;    // 上一条日志的级别
+  size_t hash_ = 0;                              // 上一条日志的消息哈希
+  uint64_t repeats_ = 0;                         // 被折叠的条数
+  std::chrono::steady_clock::time_point first_;  // 本段重复的起始时间
+  std::shared_ptr<LogEvent> last_;               // 最近一条被折叠的日志
+  MutexType lock_;
+};
+
 class LogAppender {
   friend class Logger;
 
@@ -115,7 +188,7 @@ class LogAppender {
 
   /**
    * @brief 写入日志
-   * @param logger 日志器
+   * @param logger 日志器，定时器补发或日志器已销毁后补发的折叠摘要为空
    * @param level 日志级别
    * @param event 日志事件
    */
@@ -142,10 +215,247 @@ class LogAppender {
    */
   void setFormatter(std::shared_ptr<LogFormatter> formatter);
 
+  /**
+   * @brief 设置重复日志折叠窗口
+   * @param window_ms 折叠窗口(毫秒)，为0时关闭折叠
+   */
+  void setRepeatWindow(uint32_t window_ms);
+
+  /**
+   * @brief 输出尚未输出的 "repeated N times" 摘要
+   */
+  void flushRepeat();
+
+  /**
+   * @brief 写出缓冲的日志，包括尚未输出的 "repeated N times" 摘要
+   */
+  virtual void flush();
+
+ protected:
+  /**
+   * @brief 折叠窗口已过时输出摘要，由具体Appender的定时器调用
+   */
+  void flushExpiredRepeat();
+
+ private:
+  /**
+   * @brief 输出折叠摘要
+   * @param logger 交给 log() 的日志器，定时器线程上为空
+   */
+  void logSummary(std::shared_ptr<Logger> logger,
+                  const std::shared_ptr<LogEvent>& summary);
+
+  /**
+   * @brief 经过重复折叠后再写入日志，由Logger调用
+   */
+  void append(std::shared_ptr<Logger> logger, LogLevel::Level level,
+              std::shared_ptr<LogEvent> event);
+
  protected:
   LogLevel::Level level_ = LogLevel::DEBUG;  // 日志级别
   bool has_formatter_ = false;               // 是否有日志格式器
   std::shared_ptr<LogFormatter> formatter_;  // 日志格式器
+  // 重复日志折叠，为空时不折叠
+  std::shared_ptr<LogRepeatFilter> repeat_filter_;
+  RWMutexType lock_;  // 保护 formatter_ 与 repeat_filter_
+};
+
+// 后台定时器，按固定间隔调用回调，用于在没有新日志时写出缓冲
+class LogFlushTimer {
+ public:
+  /**
+   * @brief 构造函数，立即启动后台线程
+   * @param interval_ms 调用间隔(毫秒)
+   * @param callback 回调，在后台线程中执行
+   */
+  LogFlushTimer(uint32_t interval_ms, std::function<void()> callback);
+  ~LogFlushTimer();
+
+  LogFlushTimer(const LogFlushTimer&) = delete;
+  LogFlushTimer& operator=(const LogFlushTimer&) = delete;
+
+  /**
+   * @brief 让后台线程立即调用一次回调，不等待本次间隔结束
+   */
+  void wakeup();
+
+  /**
+   * @brief 停止并等待后台线程退出，之后不会再调用回调
+   */
+  void stop();
+
+ private:
+  uint32_t interval_ms_;
+  std::function<void()> callback_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stopped_ = false;
+  bool wakeup_ = false;  // wakeup() 请求尚未处理
+  std::thread thread_;  // 在构造函数体中启动，此时其他成员已就绪
+};
+
+// 输出到文件的Appender
+class FileLogAppender : public LogAppender {
+ public:
+  /**
+   * @brief 构造函数
+   * @param filename 日志文件
+   * @param index_every 每段索引最多的记录数，为0时不写索引
+   * @details 开启索引时同时写 filename + ".idx"，每 index_every 条或
+   *  每秒记录一个段的偏移、时间范围和级别，供 logsearch 按时间定位。
+   *  后台定时器每 kFlushIntervalMs 将日志和索引刷到磁盘，运行中的
+   *  日志最迟约一秒后可被 logsearch 检索
+   */
+  explicit FileLogAppender(const std::string& filename,
+                           uint32_t index_every = 1024);
+  ~FileLogAppender() override;
+
+  void log(std::shared_ptr<Logger> logger, LogLevel::Level level,
+           std::shared_ptr<LogEvent> event) override;
+
+  /**
+   * @brief 重新打开日志文件，用于外部轮转之后
+   * @details 轮转时需要把 .idx 文件与日志文件一起移走
+   * @return 打开成功返回true
+   */
+  bool reopen();
+
+  /**
+   * @brief 输出重复折叠摘要，并将已写入的日志和索引刷到磁盘
+   */
+  void flush() override;
+
+ private:
+  /**
+   * @brief 将已写入的日志和索引刷到磁盘
+   */
+  void flushFile();
+
+ private:
+  static constexpr uint32_t kFlushIntervalMs = 1000;
+
+  std::string filename_;
+  std::ofstream filestream_;
+  uint64_t offset_ = 0;  // 当前写入偏移
+  uint32_t index_every_;
+  std::unique_ptr<LogIndexWriter> index_;  // 稀疏时间索引，可为空
+  MutexType file_lock_;                    // 保护文件写入
+  LogFlushTimer timer_;                    // 定时刷盘并输出过期摘要，最后构造
+};
+
+// 输出到标准输出/标准错误的Appender
+class ConsoleLogAppender : public LogAppender {
+ public:
+  /**
+   * @brief 构造函数
+   * @param fd STDOUT_FILENO 或 STDERR_FILENO
+   * @param batch_size 缓冲达到该字节数时调用一次write(2)
+   * @param max_pending fd写不出去时最多积压的字节数(含正在写出的一批)，
+   *  超出后丢弃新日志，ERROR及以上同样丢弃，丢弃条数之后补写一行
+   * @details 不经过iostream，生产者只追加缓冲区，write(2) 都由后台
+   *  定时器线程调用：fd为终端时按级别着色并逐条唤醒它，否则攒满一批或
+   *  遇到ERROR及以上时唤醒，其余每 kFlushIntervalMs 写出一次。fd阻塞
+   *  (例如读端很慢的管道)时只有定时器线程等待，积压超过 max_pending
+   *  后生产者丢弃日志；fd为非阻塞时遇到EAGAIN保留未写完的数据等下次
+   *  重试。进程退出前应调用 flush()，否则最后不到 kFlushIntervalMs
+   *  的日志会丢失
+   */
+  explicit ConsoleLogAppender(int fd = STDOUT_FILENO,
+                              size_t batch_size = 64 * 1024,
+                              size_t max_pending = 4 * 1024 * 1024);
+  ~ConsoleLogAppender() override;
+
+  void log(std::shared_ptr<Logger> logger, LogLevel::Level level,
+           std::shared_ptr<LogEvent> event) override;
+
+  /**
+   * @brief 输出重复折叠摘要并写出缓冲区中的日志，遇到EAGAIN时不等待
+   */
+  void flush() override;
+
+  /**
+   * @brief 同 flush()
+   * @param timeout_ms 遇到EAGAIN时最多等待的毫秒数
+   */
+  void flush(int timeout_ms);
+
+ private:
+  /**
+   * @brief 尝试写出积压的数据，由定时器线程和 flush() 调用，同一时刻
+   *  只有一个线程写fd
+   * @return 数据全部写出返回true
+   */
+  bool drain();
+
+  /**
+   * @brief 写出 back_ 与 front_ 中的数据，调用者需持有 flushing_
+   * @return 遇到EAGAIN返回false
+   */
+  bool writeOut();
+
+ private:
+  static constexpr uint32_t kFlushIntervalMs = 100;
+
+  int fd_;
+  bool color_;  // fd是否为终端
+  size_t batch_size_;
+  size_t max_pending_;
+  std::string front_;                      // 生产者追加的缓冲区
+  std::string back_;                       // 正在写出的缓冲区
+  size_t back_written_ = 0;                // back_ 中已写出的字节数
+  std::atomic<size_t> back_pending_{0};    // back_ 中未写出的字节数
+  uint64_t dropped_ = 0;                   // 因积压被丢弃的日志条数
+  std::atomic<bool> flushing_{false};      // 是否有线程正在写fd
+  MutexType buffer_lock_;                  // 保护 front_ 与 dropped_
+  LogFlushTimer timer_;                    // 定时写出，最后构造
+};
+
+// 回溯缓冲区，保存最近被级别过滤掉的日志事件
+class LogBacktrace {
+ public:
+  struct Item {
+    LogLevel::Level level;
+    std::shared_ptr<LogEvent> event;
+  };
+
+  /**
+   * @brief 开启回溯
+   * @param capacity 保存的事件数
+   * @param trigger 触发输出的最低级别
+   */
+  void enable(size_t capacity, LogLevel::Level trigger);
+
+  /**
+   * @brief 关闭回溯并丢弃已保存的事件
+   */
+  void disable();
+
+  bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 该级别的日志是否触发输出
+   */
+  bool isTrigger(LogLevel::Level level) const {
+    return isEnabled() && level >= trigger_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 保存一条事件，缓冲区满时覆盖最早的事件
+   */
+  void push(LogLevel::Level level, std::shared_ptr<LogEvent> event);
+
+  /**
+   * @brief 按时间顺序取出并清空保存的事件
+   */
+  std::vector<Item> drain();
+
+ private:
+  std::atomic<bool> enabled_{false};
+  std::atomic<LogLevel::Level> trigger_{LogLevel::ERROR};
+  // 环形缓冲区，保存的事件只以 weak_ptr 引用所属日志器，不会延长其生命周期
+  std::vector<Item> items_;
+  size_t head_ = 0;  // 下一个写入位置
+  size_t size_ = 0;  // 已保存的事件数
   MutexType lock_;
 };
 
@@ -182,6 +492,28 @@ class Logger : public std::enable_shared_from_this<Logger> {
   std::shared_ptr<LogFormatter> getFormatter();
   std::string toYamlString();
 
+  /**
+   * @brief 开启回溯模式
+   * @param size 保存最近多少条低于日志级别的事件
+   * @param trigger 达到该级别的日志先输出保存的事件
+   * @details 低于日志级别的事件只保存指针，不经过格式化和Appender
+   */
+  void enableBacktrace(size_t size, LogLevel::Level trigger = LogLevel::ERROR);
+  void disableBacktrace();
+
+  /**
+   * @brief 立即输出保存的事件
+   */
+  void dumpBacktrace();
+
+ private:
+  /**
+   * @brief 交给自身的Appender输出
+   * @return 没有Appender时返回false
+   */
+  bool callAppenders(LogLevel::Level level,
+                     const std::shared_ptr<LogEvent>& event);
+
  private:
   std::string name_;
   LogLevel::Level level_;
@@ -189,6 +521,7 @@ class Logger : public std::enable_shared_from_this<Logger> {
   std::list<std::shared_ptr<LogAppender>> appenders_;
   std::shared_ptr<LogFormatter> formatter_;
   std::shared_ptr<Logger> root_logger_;
+  LogBacktrace backtrace_;
 };
 
 // 日志队列
@@ -229,6 +562,12 @@ class LogFormatter {
 
   std::string format(std::shared_ptr<Logger> logger, LogLevel::Level level,
                      std::shared_ptr<LogEvent> event);
+  /**
+   * @brief 格式化并追加到buffer，避免生成临时string
+   */
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event);
 
  public:
   // 格式项基类
@@ -239,15 +578,19 @@ class LogFormatter {
                         LogLevel::Level level,
                         const std::shared_ptr<LogEvent>& event);
     virtual void format(fmt::memory_buffer& buffer,
-                        const std::shared_ptr<Logger> logger,
+                        const std::shared_ptr<Logger>& logger,
                         LogLevel::Level level,
-                        std::shared_ptr<LogEvent> event) = 0;
+                        const std::shared_ptr<LogEvent>& event) = 0;
   };
 
  private:
   std::string pattern_;
   std::vector<std::shared_ptr<FormatItem>> items_;
   bool error_ = false;  // 是否存在错误
+  // 只由字面量、%m 和 %n 组成的格式(如 "%m%n")直接按片段拼接，
+  // 不经过 FormatItem 的虚调用。片段为空串时表示消息
+  bool simple_ = false;
+  std::vector<std::string> pieces_;
 
   // 定义工厂函数类型
   using FormatFactory =
@@ -267,7 +610,9 @@ class NameFormatItem final : public LogFormatter::FormatItem {
   void format(std::ostream& os, const std::shared_ptr<Logger>& logger,
               LogLevel::Level level,
               const std::shared_ptr<LogEvent>& event) override {
-    fmt::print(os, "{}", event->getLogger()->getName());
+    // 日志器可能已销毁，见 LogEvent::logger_
+    auto owner = event->getLogger();
+    fmt::print(os, "{}", owner ? owner->getName() : "");
   }
 };
 
@@ -289,8 +634,9 @@ class DateTimeFormatItem final : public LogFormatter::FormatItem {
     fmt::print(os, format_, event->getTime());
   }
 
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), format_, event->getTime());
   }
 
@@ -307,8 +653,9 @@ class FilenameFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", event->getFile());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", event->getFile());
   }
 };
@@ -322,8 +669,9 @@ class LineFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", event->getLine());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", event->getLine());
   }
 };
@@ -337,9 +685,10 @@ class NewLineFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "\n");
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
-    fmt::format_to(std::back_inserter(buffer), "\n");
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
+    buffer.push_back('\n');
   }
 };
 
@@ -352,9 +701,11 @@ class MessageFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", event->getContent());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->getContent());
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
+    const std::string& content = event->getContent();
+    buffer.append(content.data(), content.data() + content.size());
   }
 };
 
@@ -367,8 +718,9 @@ class ThreadIdFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt ::print(os, "{}", event->getThreadId());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", event->getThreadId());
   }
 };
@@ -382,8 +734,9 @@ class LevelFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", LogLevel::toString(level));
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", LogLevel::toString(level));
   }
 };
@@ -397,8 +750,9 @@ class ElapseFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", event->getElapse());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", event->getElapse());
   }
 };
@@ -412,9 +766,10 @@ class TabFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "\t");
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
-    fmt::format_to(std::back_inserter(buffer), "\t");
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
+    buffer.push_back('\t');
   }
 };
 
@@ -427,8 +782,9 @@ class ThreadNameFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", event->getThreadName());
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
     fmt::format_to(std::back_inserter(buffer), "{}", event->getThreadName());
   }
 };
@@ -457,9 +813,10 @@ class StringFormatItem final : public LogFormatter::FormatItem {
               const std::shared_ptr<LogEvent>& event) override {
     fmt::print(os, "{}", string_);
   }
-  void format(fmt::memory_buffer& buffer, const std::shared_ptr<Logger> logger,
-              LogLevel::Level level, std::shared_ptr<LogEvent> event) override {
-    fmt::format_to(std::back_inserter(buffer), "{}", string_);
+  void format(fmt::memory_buffer& buffer,
+              const std::shared_ptr<Logger>& logger, LogLevel::Level level,
+              const std::shared_ptr<LogEvent>& event) override {
+    buffer.append(string_.data(), string_.data() + string_.size());
   }
 
  private:
@@ -0,0 +1,115 @@
+// 控制台输出基准测试：同一条 "%m%n" 日志分别用 printf、
+// ConsoleLogAppender::log 与 Logger::log 输出，比较每秒记录数
+//  printf             每条格式化消息并输出
+//  ConsoleLogAppender 事件已构造好，只计格式化与缓冲的开销
+//  Logger             每条构造事件、格式化消息，经 Logger 交给Appender
+// 用法: log_bench [记录数] > /dev/null  (或重定向到文件/管道，不要输出到终端)
+
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "log.hpp"
+
+namespace {
+
+constexpr int kRounds = 3;  // 每种方式运行的轮数，取最好的一轮
+
+// 返回耗时(纳秒)
+template <typename Fn>
+int64_t timeIt(Fn&& fn) {
+  auto begin = std::chrono::steady_clock::now();
+  fn();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+      .count();
+}
+
+void report(const char* name, uint64_t records, int64_t ns) {
+  fmt::print(stderr, "{:<20} {:>9.1f} ns/record  {:>8.2f} Mrecords/s\n", name,
+             static_cast<double>(ns) / records, records * 1e3 / ns);
+}
+
+// printf 逐条格式化并输出，stdout 重定向时为全缓冲
+int64_t benchPrintf(uint64_t records) {
+  return timeIt([&] {
+    for (uint64_t i = 0; i < records; ++i) {
+      std::printf("bench record %lu\n", static_cast<unsigned long>(i));
+    }
+    std::fflush(stdout);
+  });
+}
+
+std::shared_ptr<Logging::ConsoleLogAppender> makeAppender() {
+  auto appender = std::make_shared<Logging::ConsoleLogAppender>(STDOUT_FILENO);
+  appender->setFormatter(std::make_shared<Logging::LogFormatter>("%m%n"));
+  return appender;
+}
+
+int64_t benchAppender(uint64_t records) {
+  auto logger = std::make_shared<Logging::Logger>("bench");
+  auto appender = makeAppender();
+  auto event = std::make_shared<Logging::LogEvent>(
+      logger, Logging::LogLevel::INFO, __FILE__, __LINE__, 0,
+      std::this_thread::get_id(), 0, "main");
+  event->format("bench record {}", records);
+  return timeIt([&] {
+    for (uint64_t i = 0; i < records; ++i) {
+      appender->log(logger, Logging::LogLevel::INFO, event);
+    }
+    appender->flush(1000);
+  });
+}
+
+int64_t benchLogger(uint64_t records) {
+  auto logger = std::make_shared<Logging::Logger>("bench");
+  auto appender = makeAppender();
+  logger->addAppender(appender);
+
+  const auto thread_id = std::this_thread::get_id();
+  const std::string thread_name = "main";
+  return timeIt([&] {
+    for (uint64_t i = 0; i < records; ++i) {
+      auto event = std::make_shared<Logging::LogEvent>(
+          logger, Logging::LogLevel::INFO, __FILE__, __LINE__, 0, thread_id,
+          0, thread_name);
+      event->format("bench record {}", i);
+      logger->log(Logging::LogLevel::INFO, event);
+    }
+    appender->flush(1000);
+  });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t records = 1 << 22;
+  if (argc > 1) {
+    records = std::strtoull(argv[1], nullptr, 10);
+  }
+  if (::isatty(STDOUT_FILENO)) {
+    fmt::print(stderr, "stdout is a terminal, redirect it to /dev/null\n");
+    return 1;
+  }
+
+  int64_t printf_ns = INT64_MAX;
+  int64_t appender_ns = INT64_MAX;
+  int64_t logger_ns = INT64_MAX;
+  for (int round = 0; round < kRounds; ++round) {
+    printf_ns = std::min(printf_ns, benchPrintf(records));
+    appender_ns = std::min(appender_ns, benchAppender(records));
+    logger_ns = std::min(logger_ns, benchLogger(records));
+  }
+  report("printf", records, printf_ns);
+  report("ConsoleLogAppender", records, appender_ns);
+  report("Logger", records, logger_ns);
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "log_index.hpp"
+
+#include <algorithm>
+
+namespace Logging {
+
+LogIndexWriter::LogIndexWriter(uint32_t every_records, uint32_t every_ms)
+    : every_records_(std::max<uint32_t>(every_records, 1)),
+      every_ms_(every_ms) {}
+
+LogIndexWriter::~LogIndexWriter() { close(); }
+
+bool LogIndexWriter::open(const std::string &path, bool append) {
+  close();
+  file_ = std::fopen(path.c_str(), append ? "ab" : "wb");
+  return file_ != nullptr;
+}
+
+void LogIndexWriter::close() {
+  if (!file_) return;
+  commitBlock();
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+void LogIndexWriter::append(int64_t time_ms, uint64_t offset, uint32_t size,
+                            uint32_t level) {
+  if (!file_) return;
+
+  // 段必须连续，偏移不接续时(例如文件被截断)另起一段
+  if (count_ >= every_records_ ||
+      (count_ > 0 && time_ms - block_.begin_ms >= every_ms_) ||
+      (count_ > 0 && offset != block_.offset + block_.length)) {
+    commitBlock();
+  }
+
+  if (count_ == 0) {
+    block_.begin_ms = time_ms;
+    block_.end_ms = time_ms;
+    block_.offset = offset;
+    block_.length = 0;
+    block_.level_mask = 0;
+  }
+  // 多线程下时间戳可能轻微乱序，段的时间范围取最小/最大值
+  block_.begin_ms = std::min(block_.begin_ms, time_ms);
+  block_.end_ms = std::max(block_.end_ms, time_ms);
+  block_.length += size;
+  block_.level_mask |= 1u << level;
+  ++count_;
+}
+
+void LogIndexWriter::flush() {
+  if (file_) std::fflush(file_);
+}
+
+void LogIndexWriter::commitBlock() {
+  if (count_ == 0) return;
+  std::fwrite(&block_, sizeof(block_), 1, file_);
+  // 立即刷出，运行中的日志也能被 logsearch 按索引定位
+  std::fflush(file_);
+  count_ = 0;
+}
+
+}  // namespace Logging
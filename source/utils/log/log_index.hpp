@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace Logging {
+
+/**
+ * @brief 日志文件的稀疏时间索引项
+ * @details 索引文件(日志文件名 + ".idx")由连续的 LogIndexEntry 组成，
+ *  按本机字节序存储。每一项描述日志文件中的一段连续记录
+ */
+struct LogIndexEntry {
+  int64_t begin_ms;     // 段内最早的时间戳(毫秒)
+  int64_t end_ms;       // 段内最晚的时间戳(毫秒)
+  uint64_t offset;      // 段在日志文件中的起始偏移
+  uint32_t length;      // 段的字节数
+  uint32_t level_mask;  // 段内出现过的日志级别，第 level 位表示该级别
+};
+
+static_assert(sizeof(LogIndexEntry) == 32, "LogIndexEntry must be 32 bytes");
+
+// 稀疏索引写入器，由 Appender 在写入每条日志时调用
+class LogIndexWriter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param every_records 每段最多的记录数
+   * @param every_ms 每段最长的时间跨度(毫秒)
+   */
+  explicit LogIndexWriter(uint32_t every_records = 1024,
+                          uint32_t every_ms = 1000);
+  ~LogIndexWriter();
+
+  LogIndexWriter(const LogIndexWriter&) = delete;
+  LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+
+  /**
+   * @brief 打开索引文件
+   * @param path 索引文件路径
+   * @param append 是否追加到已有索引
+   */
+  bool open(const std::string& path, bool append = true);
+
+  /**
+   * @brief 写出未结束的段并关闭文件
+   */
+  void close();
+
+  /**
+   * @brief 记录一条日志
+   * @param time_ms 日志时间戳(毫秒)
+   * @param offset 日志在文件中的起始偏移
+   * @param size 日志的字节数
+   * @param level 日志级别
+   */
+  void append(int64_t time_ms, uint64_t offset, uint32_t size,
+              uint32_t level);
+
+  /**
+   * @brief 将已结束的段刷到磁盘
+   */
+  void flush();
+
+ private:
+  void commitBlock();
+
+ private:
+  uint32_t every_records_;
+  uint32_t every_ms_;
+  FILE* file_ = nullptr;
+  LogIndexEntry block_{};  // 当前未结束的段
+  uint32_t count_ = 0;     // 当前段的记录数，为0表示没有未结束的段
+};
+
+}  // namespace Logging
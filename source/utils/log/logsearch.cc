@@ -0,0 +1,335 @@
+// 日志检索工具：借助 FileLogAppender 写的 .idx 稀疏索引直接定位时间段，
+// 只扫描该时间段对应的文件切片
+//
+// 用法: logsearch [-f 开始时间] [-t 结束时间] [-l 最低级别] [-s 子串] 日志文件
+//  时间格式为 "%Y-%m-%d %H:%M:%S" (本地时间) 或秒级时间戳
+//  索引覆盖的部分时间精度为一个索引段(默认不超过1秒)；
+//  尚未写入索引的尾部及没有索引的文件按行首的 "%d{%Y-%m-%d %H:%M:%S}" 过滤
+//  级别按默认格式中的 "[%p]" 匹配
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "log_index.hpp"
+
+namespace {
+
+using Logging::LogIndexEntry;
+
+// 与 LogLevel::Level 保持一致
+const char* const kLevelTags[] = {"[UNKNOWN]", "[DEBUG]", "[INFO]",
+                                  "[WARN]",    "[ERROR]", "[FATAL]"};
+constexpr int kLevelCount = sizeof(kLevelTags) / sizeof(kLevelTags[0]);
+
+// 只读映射一个文件
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile() {
+    if (data_ && size_ > 0) munmap(data_, size_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        return false;
+      }
+      data_ = static_cast<char*>(p);
+    }
+    ::close(fd);
+    return true;
+  }
+
+  const char* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  // 提示内核顺序读取 [begin, end)
+  void adviseSequential(size_t begin, size_t end) const {
+    if (!data_ || begin >= end) return;
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t aligned = begin / page * page;
+    madvise(data_ + aligned, end - aligned, MADV_SEQUENTIAL | MADV_WILLNEED);
+  }
+
+ private:
+  char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+struct Options {
+  int64_t from_ms = std::numeric_limits<int64_t>::min();
+  int64_t to_ms = std::numeric_limits<int64_t>::max();
+  int min_level = 0;
+  std::string pattern;
+  std::string file;
+};
+
+// 解析时间参数，返回毫秒时间戳
+bool parseTime(const char* str, int64_t& ms) {
+  const char* p = str;
+  while (*p && std::isdigit(static_cast<unsigned char>(*p))) ++p;
+  if (*p == '\0' && p != str) {
+    ms = std::strtoll(str, nullptr, 10) * 1000;
+    return true;
+  }
+
+  struct tm tm {};
+  const char* end = strptime(str, "%Y-%m-%d %H:%M:%S", &tm);
+  if (!end || *end != '\0') return false;
+  tm.tm_isdst = -1;
+  ms = static_cast<int64_t>(mktime(&tm)) * 1000;
+  return true;
+}
+
+int parseLevel(const std::string& str) {
+  std::string upper = "[" + str + "]";
+  std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+  for (int i = 0; i < kLevelCount; ++i) {
+    if (upper == kLevelTags[i]) return i;
+  }
+  return -1;
+}
+
+bool lineHasLevel(const char* begin, const char* end, int min_level) {
+  if (min_level <= 0) return true;
+  size_t len = end - begin;
+  for (int i = min_level; i < kLevelCount; ++i) {
+    if (memmem(begin, len, kLevelTags[i], strlen(kLevelTags[i]))) return true;
+  }
+  return false;
+}
+
+// 扫描 [begin, end) 内的完整行，输出匹配的行
+void scanSlice(const char* begin, const char* end, const Options& opts) {
+  if (opts.pattern.empty()) {
+    const char* line = begin;
+    while (line < end) {
+      const char* nl =
+          static_cast<const char*>(memchr(line, '\n', end - line));
+      const char* line_end = nl ? nl + 1 : end;
+      if (lineHasLevel(line, line_end, opts.min_level)) {
+        fwrite(line, 1, line_end - line, stdout);
+      }
+      line = line_end;
+    }
+    return;
+  }
+
+  // 先用 memmem 在整个切片上找子串，命中后再扩展到所在行
+  const char* p = begin;
+  while (p < end) {
+    const char* hit = static_cast<const char*>(
+        memmem(p, end - p, opts.pattern.data(), opts.pattern.size()));
+    if (!hit) break;
+    const char* line =
+        static_cast<const char*>(memrchr(begin, '\n', hit - begin));
+    line = line ? line + 1 : begin;
+    const char* nl = static_cast<const char*>(memchr(hit, '\n', end - hit));
+    const char* line_end = nl ? nl + 1 : end;
+    if (lineHasLevel(line, line_end, opts.min_level)) {
+      fwrite(line, 1, line_end - line, stdout);
+    }
+    p = line_end;
+  }
+}
+
+// 解析行首 "%Y-%m-%d %H:%M:%S" 格式的时间戳，缓存到分钟避免逐行 mktime
+class LineTimeParser {
+ public:
+  bool parse(const char* line, const char* end, int64_t& ms) {
+    static constexpr size_t kLen = 19;  // "YYYY-mm-dd HH:MM:SS"
+    static constexpr size_t kMinuteLen = 16;
+    if (static_cast<size_t>(end - line) < kLen) return false;
+    for (size_t i = 0; i < kLen; ++i) {
+      bool digit = std::isdigit(static_cast<unsigned char>(line[i]));
+      bool sep = i == 4 || i == 7 || i == 10 || i == 13 || i == 16;
+      if (digit == sep) return false;
+    }
+
+    if (memcmp(line, minute_, kMinuteLen) != 0) {
+      struct tm tm {};
+      tm.tm_year = number(line, 4) - 1900;
+      tm.tm_mon = number(line + 5, 2) - 1;
+      tm.tm_mday = number(line + 8, 2);
+      tm.tm_hour = number(line + 11, 2);
+      tm.tm_min = number(line + 14, 2);
+      tm.tm_isdst = -1;
+      minute_ms_ = static_cast<int64_t>(mktime(&tm)) * 1000;
+      memcpy(minute_, line, kMinuteLen);
+    }
+    ms = minute_ms_ + number(line + 17, 2) * 1000;
+    return true;
+  }
+
+ private:
+  static int number(const char* p, int n) {
+    int v = 0;
+    for (int i = 0; i < n; ++i) v = v * 10 + (p[i] - '0');
+    return v;
+  }
+
+  char minute_[16] = {};
+  int64_t minute_ms_ = 0;
+};
+
+// 按行首时间戳扫描 [begin, end)，用于没有索引覆盖的部分
+// 没有时间戳的行(多行日志的后续行)沿用上一行的判断
+void scanTimed(const char* begin, const char* end, const Options& opts) {
+  // 多线程写入时时间戳可能轻微乱序，超过结束时间1秒后才停止扫描
+  static constexpr int64_t kDisorderMs = 1000;
+  LineTimeParser parser;
+  bool in_range = false;
+  const char* line = begin;
+  while (line < end) {
+    const char* nl = static_cast<const char*>(memchr(line, '\n', end - line));
+    const char* line_end = nl ? nl + 1 : end;
+    int64_t ms;
+    if (parser.parse(line, line_end, ms)) {
+      if (ms > opts.to_ms && ms - opts.to_ms > kDisorderMs) return;
+      in_range = ms >= opts.from_ms && ms <= opts.to_ms;
+    }
+    if (in_range && lineHasLevel(line, line_end, opts.min_level) &&
+        (opts.pattern.empty() ||
+         memmem(line, line_end - line, opts.pattern.data(),
+                opts.pattern.size()))) {
+      fwrite(line, 1, line_end - line, stdout);
+    }
+    line = line_end;
+  }
+}
+
+// 段内出现过不低于 min_level 的级别
+bool blockHasLevel(const LogIndexEntry& entry, int min_level) {
+  return min_level <= 0 || (entry.level_mask >> min_level) != 0;
+}
+
+void usage(const char* prog) {
+  fprintf(stderr,
+          "usage: %s [-f from] [-t to] [-l level] [-s substring] logfile\n"
+          "  from/to: \"%%Y-%%m-%%d %%H:%%M:%%S\" or unix seconds\n",
+          prog);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opts;
+  int c;
+  while ((c = getopt(argc, argv, "f:t:l:s:h")) != -1) {
+    switch (c) {
+      case 'f':
+        if (!parseTime(optarg, opts.from_ms)) {
+          fprintf(stderr, "invalid time: %s\n", optarg);
+          return 2;
+        }
+        break;
+      case 't':
+        if (!parseTime(optarg, opts.to_ms)) {
+          fprintf(stderr, "invalid time: %s\n", optarg);
+          return 2;
+        }
+        // 结束时间包含整秒
+        opts.to_ms += 999;
+        break;
+      case 'l':
+        opts.min_level = parseLevel(optarg);
+        if (opts.min_level < 0) {
+          fprintf(stderr, "invalid level: %s\n", optarg);
+          return 2;
+        }
+        break;
+      case 's':
+        opts.pattern = optarg;
+        break;
+      default:
+        usage(argv[0]);
+        return 2;
+    }
+  }
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+    return 2;
+  }
+  opts.file = argv[optind];
+
+  MappedFile log;
+  if (!log.open(opts.file)) {
+    perror(opts.file.c_str());
+    return 1;
+  }
+  static char out_buffer[1 << 16];
+  setvbuf(stdout, out_buffer, _IOFBF, sizeof(out_buffer));
+
+  const char* data = log.data();
+  const size_t size = log.size();
+
+  MappedFile index;
+  if (!index.open(opts.file + ".idx")) {
+    fprintf(stderr, "%s.idx not found, scanning whole file\n",
+            opts.file.c_str());
+    log.adviseSequential(0, size);
+    scanTimed(data, data + size, opts);
+    return 0;
+  }
+
+  const auto* entries = reinterpret_cast<const LogIndexEntry*>(index.data());
+  const size_t count = index.size() / sizeof(LogIndexEntry);
+
+  // 段按写入顺序排列，end_ms 单调不减，二分找到第一个可能命中的段
+  const LogIndexEntry* first =
+      std::partition_point(entries, entries + count,
+                           [&](const LogIndexEntry& e) {
+                             return e.end_ms < opts.from_ms;
+                           });
+  const LogIndexEntry* last =
+      std::partition_point(first, entries + count,
+                           [&](const LogIndexEntry& e) {
+                             return e.begin_ms <= opts.to_ms;
+                           });
+
+  auto blockEnd = [&](const LogIndexEntry* e) -> size_t {
+    return std::min<size_t>(e->offset + e->length, size);
+  };
+
+  if (first < last) {
+    log.adviseSequential(first->offset, blockEnd(last - 1));
+  }
+  for (const LogIndexEntry* e = first; e < last; ++e) {
+    if (!blockHasLevel(*e, opts.min_level)) continue;
+    size_t begin = std::min<size_t>(e->offset, size);
+    scanSlice(data + begin, data + blockEnd(e), opts);
+  }
+
+  // 尚未写入索引的尾部按行首时间戳过滤
+  size_t tail = count > 0 ? blockEnd(entries + count - 1) : 0;
+  if (tail < size) scanTimed(data + tail, data + size, opts);
+  return 0;
+}
@@ -1 +1,5 @@
-#include "lock/spinlock.h"
\ No newline at end of file
+#include "lock/lock_guard.h"
+#include "lock/mcslock.h"
+#include "lock/rwlock.h"
+#include "lock/spinlock.h"
+#include "lock/ticketlock.h"
\ No newline at end of file